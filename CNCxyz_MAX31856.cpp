@@ -1,6 +1,7 @@
 #include "CNCxyz_MAX31856.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <SPI.h>
 
 static const SPISettings settings = SPISettings(500000, MSBFIRST, SPI_MODE1);
@@ -13,7 +14,7 @@ static const uint16_t T_CONV_50Hz_ms = 185;
     @retval None
 */
 CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs) : _cs(cs), 
-_sck(-1), _miso(-1), _mosi(-1), _tc_type(MAX31856_TC_TYPE_K) {
+_sck(-1), _miso(-1), _mosi(-1), _tc_type(MAX31856_TC_TYPE_K), _scheduled(false), _converting(false), _stats() {
 }
 
 /**
@@ -23,7 +24,7 @@ _sck(-1), _miso(-1), _mosi(-1), _tc_type(MAX31856_TC_TYPE_K) {
     @retval None
 */
 CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs, const MAX31856_TCTypeT tc) :
-  _cs(cs), _tc_type(tc), _sck(-1), _miso(-1), _mosi(-1) {
+  _cs(cs), _tc_type(tc), _sck(-1), _miso(-1), _mosi(-1), _scheduled(false), _converting(false), _stats() {
 }
 
 /**
@@ -36,7 +37,7 @@ CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs, const MAX31856_TCTypeT tc) :
 */
 CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs, const int8_t mosi,
   const int8_t miso, const int8_t sck) : _cs(cs), _sck(sck), _miso(miso), _mosi(mosi),
-  _tc_type(MAX31856_TC_TYPE_K) {  
+  _tc_type(MAX31856_TC_TYPE_K), _scheduled(false), _converting(false), _stats() {  
 }
 
 /**
@@ -50,7 +51,7 @@ CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs, const int8_t mosi,
 */
 CNCxyz_MAX31856::CNCxyz_MAX31856(const int8_t cs, const int8_t mosi,
   const int8_t miso, const int8_t sck, const MAX31856_TCTypeT tc) :
-  _cs(cs), _mosi(mosi), _miso(miso), _sck(sck), _tc_type(tc) {
+  _cs(cs), _mosi(mosi), _miso(miso), _sck(sck), _tc_type(tc), _scheduled(false), _converting(false), _stats() {
 }
 
 /**
@@ -102,28 +103,41 @@ MAX31856_TCTypeT CNCxyz_MAX31856::getThermocoupleType(void) {
 */
 void CNCxyz_MAX31856::convert(void) {
   // Get current settings  
-  uint16_t conversionTime_ms;
-  uint8_t samples = getAvergingMode();
-  MAX31856_FilterT noiseFilter = getNoiseFilter();
-  
+  uint16_t conversionTime_ms = getConversionTime();
+
   // Start single conversion
+  startConversion();
+
+  // Wait until the end of conversion
+  delay(conversionTime_ms);
+}
+
+/**
+    @brief  Starts single temperature conversion
+    @param  None
+    @retval None
+    @note   Does not wait for the end of conversion, see getConversionTime()
+*/
+void CNCxyz_MAX31856::startConversion(void) {
   uint8_t CR0 = read(MAX31856_REG_CR0);
   CR0 &= ~MAX31856_REG_CR0_AUTOCONVERT;
   CR0 |= MAX31856_REG_CR0_1SHOT;
   write(MAX31856_REG_CR0, CR0);
+}
+
+/**
+    @brief  Calculates single conversion time for the current settings
+    @param  None
+    @retval Conversion time in milliseconds
+*/
+uint16_t CNCxyz_MAX31856::getConversionTime(void) {
+  uint8_t samples = getAvergingMode();
 
   // Calculate conversion time(p.20)
-  switch (noiseFilter) {
-    case MAX31856_NoiseFilter60Hz:
-      conversionTime_ms = T_CONV_60Hz_ms + (samples - 1) * 34;
-      break;
-    case MAX31856_NoiseFilter50Hz:
-      conversionTime_ms = T_CONV_50Hz_ms + (samples - 1) * 40;
-      break;
+  if (MAX31856_NoiseFilter50Hz == getNoiseFilter()) {
+    return T_CONV_50Hz_ms + (samples - 1) * 40;
   }
-
-  // Wait until the end of conversion
-  delay(conversionTime_ms);
+  return T_CONV_60Hz_ms + (samples - 1) * 34;
 }
 
 /**
@@ -137,11 +151,7 @@ float CNCxyz_MAX31856::readThermocouple(void) {
   readMultiple(MAX31856_REG_LTCBH, buf, 3);
 
   // Converting linearized TC temperature code to real temperature
-  int32_t temp_code = ((int32_t)buf[0] << 16) | ((int32_t)buf[1] << 8) | ((int32_t)buf[2] & 0xE0);
-  if (temp_code & 0x800000) {
-    temp_code |= 0xFF000000;
-  }
-  temp_code >>= 5;
+  int32_t temp_code = decodeThermocouple(buf);
   float temperature = (float) temp_code / (1 << 7);
 
   return temperature;
@@ -158,7 +168,7 @@ float CNCxyz_MAX31856::readColdJunction(void) {
   readMultiple(MAX31856_REG_CJTH, buf, 2);
 
   // Converting code to real temperature
-  int16_t temp_code = ((int16_t)buf[0] << 8) | (int16_t)buf[1];
+  int16_t temp_code = decodeColdJunction(buf);
   float temperature = (float)temp_code / (1 << 8);
 
   return temperature;
@@ -237,6 +247,21 @@ MAX31856_FilterT CNCxyz_MAX31856::getNoiseFilter(void) {
 }
 
 
+/**
+    @brief  Reads cold-junction, thermocouple and fault registers in one transfer
+    @param  sample[out] : temperature codes and fault register value
+    @retval None
+*/
+void CNCxyz_MAX31856::readSample(MAX31856_SampleT* const sample) {
+  // Read CJTH, CJTL, LTCBH, LTCBM, LTCBL and SR
+  uint8_t buf[6];
+  readMultiple(MAX31856_REG_CJTH, buf, 6);
+
+  sample->coldJunction = decodeColdJunction(&buf[0]);
+  sample->thermocouple = decodeThermocouple(&buf[2]);
+  sample->fault = buf[5];
+}
+
 /**
     @brief  Reads fault register
     @param  None
@@ -432,6 +457,131 @@ MAX31856_OCModeT CNCxyz_MAX31856::getOCDetectionMode(void) {
   return (MAX31856_OCModeT) (MAX31856_OCMode_100ms & read(MAX31856_REG_CR0));
 }
 
+/**
+    @brief  Starts duty-cycled acquisition in Normally Off mode
+    @param  interval_ms[in] : sample interval, milliseconds
+    @retval None
+    @note   Conversion settings are cached, call again after changing them.
+            The interval is extended to the conversion time if shorter.
+*/
+void CNCxyz_MAX31856::startSchedule(const uint32_t interval_ms) {
+  // Keep the converter idle between one-shots
+  setConversionMode(MAX31856_ConversionMode_NormOff);
+
+  // Cache settings so that each wake window costs only two transfers
+  _cr0 = read(MAX31856_REG_CR0) & ~(MAX31856_REG_CR0_1SHOT | MAX31856_REG_CR0_FAULTCLR);
+  _conversionTime_ms = getConversionTime();
+  _interval_ms = interval_ms;
+  if (_interval_ms < _conversionTime_ms) {
+    _interval_ms = _conversionTime_ms;
+  }
+
+  memset(&_stats, 0, sizeof(_stats));
+  _nextSample_ms = millis();
+  _lastWakeEnd_ms = _nextSample_ms;
+  _converting = false;
+  _scheduled = true;
+}
+
+/**
+    @brief  Stops duty-cycled acquisition
+    @param  None
+    @retval None
+    @note   Conversion in progress, if any, is left to complete
+*/
+void CNCxyz_MAX31856::stopSchedule(void) {
+  _scheduled = false;
+  _converting = false;
+}
+
+/**
+    @brief  Runs duty-cycled acquisition, call from the main loop
+    @param  sample[out] : acquired sample, written only when true is returned
+    @retval true when a new sample is available
+    @note   Triggers a one-shot when the sample slot is due, and reads cold-junction,
+            thermocouple and fault registers in one burst once conversion is done.
+            Call getSleepTime() afterwards to find how long the host may sleep.
+*/
+bool CNCxyz_MAX31856::poll(MAX31856_SampleT* const sample) {
+  if (!_scheduled) {
+    return false;
+  }
+
+  uint32_t now = millis();
+  uint32_t start_us;
+
+  if (!_converting) {
+    // Wait for the next sample slot
+    if ((int32_t)(now - _nextSample_ms) < 0) {
+      return false;
+    }
+
+    // Polled too late, skip lost slots and restart the cadence from now
+    uint32_t late_ms = now - _nextSample_ms;
+    if (late_ms >= _interval_ms) {
+      _stats.missed += late_ms / _interval_ms;
+      _nextSample_ms = now;
+    }
+    _stats.idleTime_ms = now - _lastWakeEnd_ms;
+
+    // Trigger one-shot conversion
+    start_us = micros();
+    write(MAX31856_REG_CR0, _cr0 | MAX31856_REG_CR0_1SHOT);
+    _stats.busTime_us = micros() - start_us;
+
+    // Conversion starts after the write, not at the slot time
+    _conversionStart_ms = millis();
+    _nextSample_ms += _interval_ms;
+    _converting = true;
+    return false;
+  }
+
+  // Wait until the end of conversion, one extra tick covers millis() granularity
+  if (now - _conversionStart_ms <= _conversionTime_ms) {
+    return false;
+  }
+
+  // Read cold-junction, thermocouple and fault registers
+  start_us = micros();
+  readSample(sample);
+  _stats.busTime_us += micros() - start_us;
+
+  _stats.conversionTime_ms = now - _conversionStart_ms;
+  _stats.samples++;
+  _lastWakeEnd_ms = millis();
+  _converting = false;
+  return true;
+}
+
+/**
+    @brief  Gets time the host may sleep before the next poll() call
+    @param  None
+    @retval Sleep time in milliseconds, 0 if poll() should be called now
+*/
+uint32_t CNCxyz_MAX31856::getSleepTime(void) {
+  if (!_scheduled) {
+    return 0;
+  }
+
+  uint32_t now = millis();
+  int32_t remaining;
+  if (_converting) {
+    remaining = (int32_t)(_conversionStart_ms + _conversionTime_ms + 1 - now);
+  } else {
+    remaining = (int32_t)(_nextSample_ms - now);
+  }
+  return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+/**
+    @brief  Gets wake-window statistics of the last scheduled sample
+    @param  stats[out] : statistics
+    @retval None
+*/
+void CNCxyz_MAX31856::getWakeStats(MAX31856_WakeStatsT* const stats) {
+  *stats = _stats;
+}
+
 //------------------------------ Private functions ----------------------------
 /**
     @brief  Read MAX31856 register
@@ -538,3 +688,193 @@ uint8_t CNCxyz_MAX31856::transfer(const uint8_t val) {
   }
   return out;
 }
+
+/**
+    @brief  Decodes linearized TC temperature registers
+    @param  buf [in]: LTCBH, LTCBM and LTCBL register values
+    @retval Temperature code, 1/128 Celsius degree per LSB
+*/
+int32_t CNCxyz_MAX31856::decodeThermocouple(const uint8_t* const buf) {
+  int32_t temp_code = ((int32_t)buf[0] << 16) | ((int32_t)buf[1] << 8) | ((int32_t)buf[2] & 0xE0);
+  if (temp_code & 0x800000) {
+    temp_code |= 0xFF000000;
+  }
+  return temp_code >> 5;
+}
+
+/**
+    @brief  Decodes cold-junction temperature registers
+    @param  buf [in]: CJTH and CJTL register values
+    @retval Temperature code, 1/256 Celsius degree per LSB
+*/
+int16_t CNCxyz_MAX31856::decodeColdJunction(const uint8_t* const buf) {
+  return ((int16_t)buf[0] << 8) | (int16_t)buf[1];
+}
+
+//------------------------------ Text formatting ------------------------------
+/**
+    @brief  Writes unsigned integer as decimal text
+    @param  buf [out]: text buffer, at least 10 bytes
+    @param  value [in]: value to write
+    @retval Number of characters written
+*/
+static uint8_t formatUnsigned(char* const buf, uint32_t value) {
+  char digits[10];
+  uint8_t n = 0;
+
+  // Use 16-bit division where possible, it is much cheaper on 8-bit targets
+  while (value > 0xFFFF) {
+    digits[n++] = '0' + (char)(value % 10);
+    value /= 10;
+  }
+  uint16_t small = (uint16_t)value;
+  do {
+    digits[n++] = '0' + (char)(small % 10);
+    small /= 10;
+  } while (small);
+
+  for (uint8_t i = 0; i < n; ++i) {
+    buf[i] = digits[n - 1 - i];
+  }
+  return n;
+}
+
+/**
+    @brief  Writes fixed-point temperature code as exact decimal text
+    @param  buf [out]: text buffer, at least MAX31856_FIXED_BUF_SIZE bytes
+    @param  code [in]: temperature code
+    @param  fracBits [in]: number of fractional bits of the code [1...12]
+    @retval Number of characters written, excluding terminating null, 0 if fracBits is out of range
+    @note   Trailing fractional zeros are omitted, at least one fractional digit is kept
+*/
+uint8_t MAX31856_formatFixed(char* const buf, const int32_t code, const uint8_t fracBits) {
+  // Fraction digits are computed in 16 bits, more bits would overflow
+  if ((fracBits < 1) || (fracBits > 12)) {
+    buf[0] = '\0';
+    return 0;
+  }
+
+  uint8_t n = 0;
+  uint32_t absVal = (uint32_t)code;
+
+  // Storing sign
+  if (code < 0) {
+    buf[n++] = '-';
+    absVal = 0 - absVal;
+  }
+
+  // Integer part
+  n += formatUnsigned(&buf[n], absVal >> fracBits);
+  buf[n++] = '.';
+
+  // Fractional part, each step yields one exact decimal digit
+  const uint16_t mask = (1 << fracBits) - 1;
+  uint16_t frac = (uint16_t)absVal & mask;
+  do {
+    frac *= 10;
+    buf[n++] = '0' + (char)(frac >> fracBits);
+    frac &= mask;
+  } while (frac);
+
+  buf[n] = '\0';
+  return n;
+}
+
+/**
+    @brief  Writes linearized TC temperature code as exact decimal text
+    @param  buf [out]: text buffer, at least MAX31856_FIXED_BUF_SIZE bytes
+    @param  code [in]: temperature code, 1/128 Celsius degree per LSB
+    @retval Number of characters written, excluding terminating null
+*/
+uint8_t MAX31856_formatThermocouple(char* const buf, const int32_t code) {
+  return MAX31856_formatFixed(buf, code, 7);
+}
+
+/**
+    @brief  Writes cold-junction temperature code as exact decimal text
+    @param  buf [out]: text buffer, at least MAX31856_FIXED_BUF_SIZE bytes
+    @param  code [in]: temperature code, 1/256 Celsius degree per LSB
+    @retval Number of characters written, excluding terminating null
+*/
+uint8_t MAX31856_formatColdJunction(char* const buf, const int16_t code) {
+  return MAX31856_formatFixed(buf, code, 8);
+}
+
+/**
+    @brief  Writes one sweep of samples as a framed telemetry line
+    @param  buf [out]: text buffer
+    @param  size [in]: buffer size, MAX31856_TELEMETRY_SIZE(count) bytes fit any chip readings
+    @param  seq [in]: sweep sequence number
+    @param  samples [in]: samples of the sweep, one per channel
+    @param  count [in]: number of channels
+    @retval Number of characters written, excluding terminating null, 0 if buffer is too small
+    @note   Line format: $TC,<seq>,<count>{,<tc>,<cj>,<fault>}*<checksum>\r\n
+            Temperatures are in Celsius degrees, fault and checksum are two hex digits,
+            checksum is XOR of all characters between '$' and '*'.
+            Each field is checked against size before it is appended, so codes outside
+            the chip range never overflow the buffer but may need more than
+            MAX31856_TELEMETRY_SIZE(count) bytes.
+*/
+uint16_t MAX31856_formatTelemetry(char* const buf, const uint16_t size, const uint8_t seq,
+  const MAX31856_SampleT* const samples, const uint8_t count) {
+  static const char hex[] = "0123456789ABCDEF";
+  static const uint8_t TRAILER_SIZE = 6; // "*XX\r\n" and terminating null
+  static const uint8_t HEADER_SIZE = 11; // "$TC," and two numbers up to 3 digits
+  char field[MAX31856_FIXED_BUF_SIZE];
+  uint8_t len;
+
+  // Room left for fields is kept as size - n - TRAILER_SIZE to avoid overflow
+  if (size < HEADER_SIZE + TRAILER_SIZE) {
+    return 0;
+  }
+
+  // Header
+  uint16_t n = 0;
+  buf[n++] = '$';
+  buf[n++] = 'T';
+  buf[n++] = 'C';
+  buf[n++] = ',';
+  n += formatUnsigned(&buf[n], seq);
+  buf[n++] = ',';
+  n += formatUnsigned(&buf[n], count);
+
+  // Channels
+  for (uint8_t i = 0; i < count; ++i) {
+    len = MAX31856_formatThermocouple(field, samples[i].thermocouple);
+    if ((uint16_t)(len + 1) > size - n - TRAILER_SIZE) {
+      return 0;
+    }
+    buf[n++] = ',';
+    memcpy(&buf[n], field, len);
+    n += len;
+
+    len = MAX31856_formatColdJunction(field, samples[i].coldJunction);
+    if ((uint16_t)(len + 1) > size - n - TRAILER_SIZE) {
+      return 0;
+    }
+    buf[n++] = ',';
+    memcpy(&buf[n], field, len);
+    n += len;
+
+    if (3 > size - n - TRAILER_SIZE) {
+      return 0;
+    }
+    buf[n++] = ',';
+    buf[n++] = hex[samples[i].fault >> 4];
+    buf[n++] = hex[samples[i].fault & 0x0F];
+  }
+
+  // Checksum
+  uint8_t checksum = 0;
+  for (uint16_t i = 1; i < n; ++i) {
+    checksum ^= (uint8_t)buf[i];
+  }
+  buf[n++] = '*';
+  buf[n++] = hex[checksum >> 4];
+  buf[n++] = hex[checksum & 0x0F];
+  buf[n++] = '\r';
+  buf[n++] = '\n';
+  buf[n] = '\0';
+
+  return n;
+}
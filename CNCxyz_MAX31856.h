@@ -103,6 +103,29 @@ typedef enum {
   MAX31856_OCMode_100ms = 0x30,   // Nominal detection time of 100 ms
 } MAX31856_OCModeT;
 
+// One sample acquired by the duty-cycled scheduler
+typedef struct {
+  int32_t thermocouple; // Linearized TC temperature code, 1/128 Celsius degree per LSB
+  int16_t coldJunction; // Cold-junction temperature code, 1/256 Celsius degree per LSB
+  uint8_t fault;        // Fault status register value
+} MAX31856_SampleT;
+
+// Wake-window statistics of the last scheduled sample
+typedef struct {
+  uint32_t busTime_us;        // SPI time spent on trigger and readout
+  uint32_t conversionTime_ms; // Time from one-shot trigger to readout
+  uint32_t idleTime_ms;       // Time between previous readout and this trigger
+  uint32_t samples;           // Number of samples acquired since schedule start
+  uint32_t missed;            // Number of sample slots skipped due to late polling
+} MAX31856_WakeStatsT;
+
+// Text buffer size for one formatted temperature code, including terminating null
+#define MAX31856_FIXED_BUF_SIZE 25
+
+// Text buffer size for a telemetry line of the given number of channels
+// with temperature codes in the chip range
+#define MAX31856_TELEMETRY_SIZE(channels) (17 + 31 * (uint16_t)(channels))
+
 class CNCxyz_MAX31856 {
 public:
   CNCxyz_MAX31856(const int8_t cs);
@@ -114,12 +137,15 @@ public:
   void setThermocoupleType(const MAX31856_TCTypeT tc);
   MAX31856_TCTypeT getThermocoupleType(void);
   void convert(void);
+  void startConversion(void);
+  uint16_t getConversionTime(void);
   float readThermocouple(void);
   float readColdJunction(void);
   void setAvergingMode(const MAX31856_AVGSEL_MaskT avgMask);
   uint8_t getAvergingMode(void);
   void setNoiseFilter(const MAX31856_FilterT filter);
   MAX31856_FilterT getNoiseFilter(void);
+  void readSample(MAX31856_SampleT* const sample);
   uint8_t readFault(void);
   void setThermocoupleRange(const float low, const float high);
   void setColdJunctionRange(const int8_t low, const int8_t high);
@@ -132,6 +158,11 @@ public:
   void clearFaults(void);
   void setOCDetectionMode(const MAX31856_OCModeT mode);
   MAX31856_OCModeT getOCDetectionMode(void);
+  void startSchedule(const uint32_t interval_ms);
+  void stopSchedule(void);
+  bool poll(MAX31856_SampleT* const sample);
+  uint32_t getSleepTime(void);
+  void getWakeStats(MAX31856_WakeStatsT* const stats);
 
 private:
   int8_t _cs;
@@ -140,12 +171,32 @@ private:
   int8_t _mosi;
   MAX31856_TCTypeT _tc_type;
 
+  // Duty-cycled scheduler state
+  bool _scheduled;
+  bool _converting;
+  uint8_t _cr0;
+  uint16_t _conversionTime_ms;
+  uint32_t _interval_ms;
+  uint32_t _nextSample_ms;
+  uint32_t _conversionStart_ms;
+  uint32_t _lastWakeEnd_ms;
+  MAX31856_WakeStatsT _stats;
+
   uint8_t read(const MAX31856_addressT address);
   void readMultiple(const MAX31856_addressT address, uint8_t* const rx_buf, const uint8_t size);
   void write(const MAX31856_addressT address, const uint8_t value);
   void writeMultiple(const MAX31856_addressT address, const uint8_t* const tx_buf, 
     const uint8_t size);
   uint8_t transfer(const uint8_t val);
+  static int32_t decodeThermocouple(const uint8_t* const buf);
+  static int16_t decodeColdJunction(const uint8_t* const buf);
 };
 
+// Allocation-free text formatting
+uint8_t MAX31856_formatFixed(char* const buf, const int32_t code, const uint8_t fracBits);
+uint8_t MAX31856_formatThermocouple(char* const buf, const int32_t code);
+uint8_t MAX31856_formatColdJunction(char* const buf, const int16_t code);
+uint16_t MAX31856_formatTelemetry(char* const buf, const uint16_t size, const uint8_t seq,
+  const MAX31856_SampleT* const samples, const uint8_t count);
+
 #endif
@@ -5,7 +5,9 @@
 
 CNCxyz_MAX31856 MAX31856(CS_PIN); // MAX31856 object
 
-char string_buf[32]; // For numbers to string conversion
+MAX31856_SampleT sample; // Temperature codes and fault flags
+char line_buf[MAX31856_TELEMETRY_SIZE(1)]; // For telemetry line
+uint8_t seq = 0; // Telemetry line sequence number
 
 void setup() {
   Serial.begin(9600);
@@ -19,18 +21,12 @@ void loop() {
   // Convert temperature
   MAX31856.convert();
 
-  // Read and display thermocouple temperature
-  float LTC = MAX31856.readThermocouple();
-  dtostrf(LTC, 8, 6, string_buf);
-  Serial.print("LTC value: ");
-  Serial.println(string_buf);
+  // Read thermocouple, cold junction and fault registers at once
+  MAX31856.readSample(&sample);
 
-  // Read and display cold junction temperature
-  float CJT = MAX31856.readColdJunction();
-  dtostrf(CJT, 8, 6, string_buf);
-  Serial.print("CJT value: ");
-  Serial.println(string_buf);
-  Serial.println();
+  // Display as one telemetry line: $TC,<seq>,1,<LTC>,<CJT>,<fault>*<checksum>
+  uint16_t len = MAX31856_formatTelemetry(line_buf, sizeof(line_buf), seq++, &sample, 1);
+  Serial.write(line_buf, len);
   
   delay(LOOP_DELAY_ms);
 }
@@ -0,0 +1,48 @@
+#include "CNCxyz_MAX31856.h"
+
+#define CS_PIN  9 // Pin number used for CS
+#define SAMPLE_INTERVAL_ms 5000 // Interval between subsequental samples
+
+CNCxyz_MAX31856 MAX31856(CS_PIN); // MAX31856 object
+
+MAX31856_SampleT sample; // Last acquired sample
+MAX31856_WakeStatsT stats; // Wake-window statistics
+char string_buf[MAX31856_FIXED_BUF_SIZE]; // For codes to string conversion
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Starting MAX31856 low-power example...");
+  MAX31856.begin();
+
+  // Set TC type
+  MAX31856.setThermocoupleType(MAX31856_TC_TYPE_K);
+
+  // Run one-shot conversions in Normally Off mode
+  MAX31856.startSchedule(SAMPLE_INTERVAL_ms);
+}
+
+void loop() {
+  if (MAX31856.poll(&sample)) {
+    MAX31856.getWakeStats(&stats);
+
+    MAX31856_formatThermocouple(string_buf, sample.thermocouple);
+    Serial.print("LTC value: ");
+    Serial.println(string_buf);
+    MAX31856_formatColdJunction(string_buf, sample.coldJunction);
+    Serial.print("CJT value: ");
+    Serial.println(string_buf);
+    Serial.print("Fault: ");
+    Serial.println(sample.fault, HEX);
+    Serial.print("Bus us / conversion ms / idle ms: ");
+    Serial.print(stats.busTime_us);
+    Serial.print(" / ");
+    Serial.print(stats.conversionTime_ms);
+    Serial.print(" / ");
+    Serial.println(stats.idleTime_ms);
+    Serial.println();
+    Serial.flush();
+  }
+
+  // Replace with the MCU sleep routine of the target board
+  delay(MAX31856.getSleepTime());
+}